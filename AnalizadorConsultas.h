@@ -0,0 +1,290 @@
+#ifndef ANALIZADORCONSULTAS_H
+#define ANALIZADORCONSULTAS_H
+
+#include <mysql.h>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <cctype>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Etiqueta con el archivo y la línea del punto de llamada, para usar con tag().
+ */
+#define ORM_CALLSITE (string(__FILE__) + ":" + to_string(__LINE__))
+
+/**
+ * @brief Problema detectado por AnalizadorConsultas.
+ */
+struct Hallazgo {
+    string tipo;        // "FULL_SCAN", "FILESORT", "TEMPORARY" o "N+1"
+    string forma;       // Consulta normalizada (literales reemplazados por ?)
+    string consulta;    // Primera consulta concreta con esa forma (en el ámbito, para N+1)
+    string etiqueta;    // Punto de llamada (tag()) o ámbito activo
+    string detalle;     // Tabla, filas estimadas, repeticiones, etc.
+};
+
+/**
+ * @brief Analizador de consultas para modo desarrollo.
+ *
+ * Los modelos (EloquentORM y MySQLModel) le notifican cada consulta antes de ejecutarla.
+ * La primera vez que aparece una forma de consulta se ejecuta EXPLAIN sobre ella y se
+ * reportan los accesos sin índice (type = ALL) y los planes con filesort o tabla temporal.
+ * Dentro de un ámbito (ver Ambito) se cuentan además las repeticiones de cada forma: al
+ * alcanzar el umbral se reporta un posible patrón N+1, como un find() dentro de un bucle.
+ *
+ * Está pensado para desarrollo y pruebas, no para producción: no es seguro entre hilos,
+ * por lo que se recomienda una instancia por hilo.
+ */
+class AnalizadorConsultas {
+private:
+    /**
+     * @brief Repeticiones de una forma dentro de un ámbito y la primera consulta concreta que la usó.
+     */
+    struct Repeticion {
+        unsigned int veces = 0;
+        string primera;
+    };
+
+    /**
+     * @brief Estado de un ámbito abierto: repeticiones por forma y formas ya reportadas como N+1.
+     */
+    struct MarcoAmbito {
+        string nombre;
+        map<string, Repeticion> conteo;
+        set<string> reportadas;
+    };
+
+    set<string> formasAnalizadas;        // Formas a las que ya se les hizo EXPLAIN
+    vector<Hallazgo> hallazgos;
+    vector<MarcoAmbito> ambitos;         // Pila de ámbitos abiertos (el último es el más interno)
+    unsigned int umbralNMas1;
+
+    /**
+     * @brief Nombre del ámbito más interno (vacío si no hay ninguno abierto).
+     */
+    string ambitoActual() const {
+        return ambitos.empty() ? string() : ambitos.back().nombre;
+    }
+
+    /**
+     * @brief Normaliza una consulta reemplazando literales de texto y numéricos por '?'.
+     */
+    static string normalizar(const string &query) {
+        string forma;
+        forma.reserve(query.size());
+        size_t i = 0, n = query.size();
+        while(i < n) {
+            char c = query[i];
+            if(c == '\'' || c == '"') {
+                // Literal de texto: se admiten comillas escapadas con \ o duplicadas.
+                size_t j = i + 1;
+                while(j < n) {
+                    if(query[j] == '\\') { j += 2; continue; }
+                    if(query[j] == c) {
+                        if(j + 1 < n && query[j + 1] == c) { j += 2; continue; }
+                        break;
+                    }
+                    j++;
+                }
+                forma += '?';
+                i = j + 1;
+            } else if(isdigit((unsigned char)c) && (forma.empty() || !(isalnum((unsigned char)forma.back()) || forma.back() == '_'))) {
+                while(i < n && (isalnum((unsigned char)query[i]) || query[i] == '.')) i++;
+                forma += '?';
+            } else if(isspace((unsigned char)c)) {
+                if(!forma.empty() && forma.back() != ' ') forma += ' ';
+                i++;
+            } else {
+                forma += c;
+                i++;
+            }
+        }
+        while(!forma.empty() && (forma.back() == ' ' || forma.back() == ';')) forma.pop_back();
+        return forma;
+    }
+
+    /**
+     * @brief Indica si la consulta admite EXPLAIN (SELECT, UPDATE, DELETE o WITH).
+     */
+    static bool explicable(const string &query) {
+        size_t i = query.find_first_not_of(" \t\r\n(");
+        if(i == string::npos) return false;
+        string verbo;
+        while(i < query.size() && isalpha((unsigned char)query[i]))
+            verbo += (char)toupper((unsigned char)query[i++]);
+        return verbo == "SELECT" || verbo == "UPDATE" || verbo == "DELETE" || verbo == "WITH";
+    }
+
+    void agregar(const string &tipo, const string &forma, const string &query,
+                 const string &etiqueta, const string &detalle) {
+        hallazgos.push_back({tipo, forma, query, etiqueta.empty() ? ambitoActual() : etiqueta, detalle});
+    }
+
+    /**
+     * @brief Ejecuta EXPLAIN y registra los accesos sin índice, filesort y tablas temporales.
+     */
+    void explicar(MYSQL *conn, const string &query, const string &forma, const string &etiqueta) {
+        string explain = "EXPLAIN " + query;
+        if(mysql_query(conn, explain.c_str())) {
+            cerr << "Error en EXPLAIN: " << mysql_error(conn) << endl;
+            return;
+        }
+        MYSQL_RES *res = mysql_store_result(conn);
+        if(!res) return;
+        unsigned int num_fields = mysql_num_fields(res);
+        MYSQL_FIELD *fields = mysql_fetch_fields(res);
+        int colTabla = -1, colTipo = -1, colFilas = -1, colExtra = -1;
+        for(unsigned int i = 0; i < num_fields; i++) {
+            string nombre = fields[i].name;
+            if(nombre == "table") colTabla = i;
+            else if(nombre == "type") colTipo = i;
+            else if(nombre == "rows") colFilas = i;
+            else if(nombre == "Extra") colExtra = i;
+        }
+        MYSQL_ROW row;
+        while((row = mysql_fetch_row(res))) {
+            string tabla = (colTabla >= 0 && row[colTabla]) ? row[colTabla] : "";
+            string tipo = (colTipo >= 0 && row[colTipo]) ? row[colTipo] : "";
+            string filas = (colFilas >= 0 && row[colFilas]) ? row[colFilas] : "?";
+            string extra = (colExtra >= 0 && row[colExtra]) ? row[colExtra] : "";
+            if(tipo == "ALL")
+                agregar("FULL_SCAN", forma, query, etiqueta, "tabla " + tabla + ", ~" + filas + " filas examinadas");
+            if(extra.find("Using filesort") != string::npos)
+                agregar("FILESORT", forma, query, etiqueta, "tabla " + tabla + ": " + extra);
+            if(extra.find("Using temporary") != string::npos)
+                agregar("TEMPORARY", forma, query, etiqueta, "tabla " + tabla + ": " + extra);
+        }
+        mysql_free_result(res);
+    }
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param umbralNMas1 Repeticiones de una misma forma dentro de un ámbito a partir de las cuales se reporta N+1 (por defecto: 3).
+     */
+    AnalizadorConsultas(unsigned int umbralNMas1 = 3)
+        : umbralNMas1(umbralNMas1 > 1 ? umbralNMas1 : 2) {}
+
+    /**
+     * @brief Delimita un ámbito de detección N+1 (por ejemplo, una petición o un caso de uso).
+     *
+     * Los ámbitos se pueden anidar (por ejemplo, un caso de uso dentro de una petición): cada
+     * consulta cuenta en todos los ámbitos abiertos y, al cerrar el interno, el externo sigue
+     * contando donde estaba.
+     */
+    class Ambito {
+    private:
+        AnalizadorConsultas &analizador;
+    public:
+        Ambito(AnalizadorConsultas &a, const string &nombre) : analizador(a) {
+            analizador.iniciarAmbito(nombre);
+        }
+        ~Ambito() {
+            analizador.terminarAmbito();
+        }
+        Ambito(const Ambito &) = delete;
+        Ambito &operator=(const Ambito &) = delete;
+    };
+
+    /**
+     * @brief Inicia un ámbito de detección N+1, anidado dentro de los que ya estén abiertos.
+     *
+     * @param nombre Nombre del ámbito; se usa como etiqueta cuando la consulta no tiene tag().
+     */
+    void iniciarAmbito(const string &nombre) {
+        ambitos.push_back(MarcoAmbito());
+        ambitos.back().nombre = nombre;
+    }
+
+    /**
+     * @brief Termina el ámbito más interno y retoma el que lo contiene.
+     *
+     * Las formas ya reportadas en el ámbito cerrado no se vuelven a reportar en el externo.
+     */
+    void terminarAmbito() {
+        if(ambitos.empty()) {
+            cerr << "AnalizadorConsultas: terminarAmbito() sin ámbito abierto." << endl;
+            return;
+        }
+        set<string> reportadas = ambitos.back().reportadas;
+        ambitos.pop_back();
+        if(!ambitos.empty())
+            ambitos.back().reportadas.insert(reportadas.begin(), reportadas.end());
+    }
+
+    /**
+     * @brief Registra una consulta que está por ejecutarse en la conexión indicada.
+     *
+     * Debe llamarse antes de ejecutar la consulta, mientras la conexión no tiene resultados pendientes.
+     *
+     * @param conn Conexión sobre la que se ejecutará EXPLAIN.
+     * @param query Consulta SQL.
+     * @param etiqueta Punto de llamada (puede estar vacío).
+     */
+    void observar(MYSQL *conn, const string &query, const string &etiqueta) {
+        string forma = normalizar(query);
+        if(formasAnalizadas.insert(forma).second && explicable(query))
+            explicar(conn, query, forma, etiqueta);
+        // Se cuenta en todos los ámbitos abiertos; se reporta una sola vez, en el más interno
+        // que alcance el umbral.
+        bool reportada = false;
+        for(auto &marco : ambitos) {
+            Repeticion &r = marco.conteo[forma];
+            if(r.veces++ == 0) r.primera = query;
+            if(marco.reportadas.count(forma)) reportada = true;
+        }
+        for(auto it = ambitos.rbegin(); it != ambitos.rend() && !reportada; ++it) {
+            const Repeticion &r = it->conteo[forma];
+            if(r.veces >= umbralNMas1) {
+                agregar("N+1", forma, r.primera, etiqueta,
+                        "la misma forma se ejecutó " + to_string(umbralNMas1) + " veces en el ámbito '" + it->nombre + "'");
+                it->reportadas.insert(forma);
+                reportada = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Retorna los hallazgos acumulados.
+     */
+    const vector<Hallazgo> &getHallazgos() const {
+        return hallazgos;
+    }
+
+    /**
+     * @brief Escribe un reporte legible de los hallazgos.
+     *
+     * @param os Flujo de salida (por ejemplo, cerr).
+     */
+    void reporte(ostream &os) const {
+        if(hallazgos.empty()) {
+            os << "AnalizadorConsultas: sin hallazgos." << endl;
+            return;
+        }
+        os << "AnalizadorConsultas: " << hallazgos.size() << " hallazgo(s)" << endl;
+        for(const auto &h : hallazgos) {
+            os << "[" << h.tipo << "] " << (h.etiqueta.empty() ? "(sin etiqueta)" : h.etiqueta) << endl
+               << "    " << h.forma << endl
+               << "    " << h.detalle << endl;
+        }
+    }
+
+    /**
+     * @brief Descarta los hallazgos y las formas ya analizadas.
+     */
+    void limpiar() {
+        hallazgos.clear();
+        formasAnalizadas.clear();
+        for(auto &marco : ambitos) {
+            marco.conteo.clear();
+            marco.reportadas.clear();
+        }
+    }
+};
+
+#endif // ANALIZADORCONSULTAS_H
@@ -2,7 +2,13 @@
 #define ELOQUENTORM_H
 
 #include "MySQLConexion.h"
+#include "MySQLExportador.h"
+#include "SingleFlight.h"
+#include "AnalizadorConsultas.h"
+#include "FilaMySQL.h"
 #include <vector>
+#include <memory>
+#include <utility>
 #include <map>
 #include <string>
 #include <sstream>
@@ -12,6 +18,11 @@
 
 using namespace std;
 
+/**
+ * @brief Grupo single-flight para lecturas de un registro (find() y first()).
+ */
+typedef SingleFlight< map<string, string> > SingleFlightRegistro;
+
 /**
  * @brief Clase que representa un modelo genérico al estilo Eloquent para MySQL.
  *
@@ -26,6 +37,44 @@ private:
     MYSQL *conn;
     string condition;                    // Condición WHERE construida con where()
     string rawQuery;                     // Consulta raw personalizada (si se establece)
+    SingleFlightRegistro *singleFlight;  // Grupo para colapsar lecturas concurrentes (opcional)
+    AnalizadorConsultas *analizador;     // Analizador de consultas en modo desarrollo (opcional)
+    string etiqueta;                     // Punto de llamada de la próxima consulta (ver tag())
+    bool lazy;                           // Hidratación diferida en find() (ver setLazyHydration())
+    FilaMySQL fila;                      // Fila cargada por find() en modo diferido; attributes tiene prioridad
+    shared_ptr<MySQLExportador> exportador; // Exportador con buffer reutilizable, compartido por las copias
+
+    /**
+     * @brief Copia a attributes las columnas del modelo que sólo están en la fila diferida.
+     *
+     * Se llama antes de create() y update(), que necesitan como propios los valores que
+     * serializan; los demás campos del resultado (por ejemplo, TEXT/BLOB que no están en
+     * columns) no se copian.
+     * La fila se conserva (sólo find() la reemplaza), de modo que las vistas obtenidas antes con
+     * getView() siguen siendo válidas.
+     */
+    void hidratar() {
+        if(fila.empty())
+            return;
+        for(auto &col : columns) {
+            if(attributes.find(col) != attributes.end())
+                continue;
+            int i = fila.indexOf(col);
+            if(i >= 0)
+                attributes[col] = string(fila.value((unsigned int)i));
+        }
+    }
+
+    /**
+     * @brief Notifica la consulta al analizador (si hay uno) y descarta la etiqueta ya usada.
+     *
+     * @param query La consulta que está por ejecutarse.
+     */
+    void analizar(const string &query) {
+        if(analizador)
+            analizador->observar(conn, query, etiqueta);
+        etiqueta.clear();
+    }
 
     /**
      * @brief Función auxiliar para ejecutar una consulta SQL.
@@ -40,6 +89,53 @@ private:
         }
         return mysql_store_result(conn);
     }
+
+    /**
+     * @brief Ejecuta una consulta y retorna su primera fila como mapa campo-valor.
+     *
+     * Si hay un grupo single-flight configurado, las llamadas concurrentes con el mismo
+     * origen de datos y consulta comparten una única ejecución, salvo que la conexión esté
+     * dentro de una transacción: en ese caso la lectura debe ver sus propias escrituras.
+     *
+     * @param query La consulta a ejecutar.
+     * @return map<string, string> Campos de la primera fila o mapa vacío si no hay resultados.
+     */
+    map<string, string> fetchFirst(const string &query) {
+        analizar(query);
+        auto leer = [this, &query]() {
+            map<string, string> record;
+            MYSQL_RES *res = execute(query);
+            if(res) {
+                MYSQL_ROW row = mysql_fetch_row(res);
+                if(row) {
+                    unsigned int num_fields = mysql_num_fields(res);
+                    MYSQL_FIELD *fields = mysql_fetch_fields(res);
+                    for(unsigned int i = 0; i < num_fields; i++) {
+                        record[string(fields[i].name)] = (row[i] ? row[i] : "");
+                    }
+                }
+                mysql_free_result(res);
+            }
+            return record;
+        };
+        if(!singleFlight || (conn->server_status & SERVER_STATUS_IN_TRANS))
+            return leer();
+        return *singleFlight->hacer(db.getDSN() + "|" + query, leer);
+    }
+
+    /**
+     * @brief Construye la consulta SELECT a partir de la condición o, si se usó raw(), la consulta personalizada.
+     *
+     * @return string Consulta SQL a ejecutar.
+     */
+    string buildQuery() const {
+        if(!rawQuery.empty())
+            return rawQuery;
+        string query = "SELECT * FROM " + table;
+        if(!condition.empty())
+            query += " WHERE " + condition;
+        return query;
+    }
 public:
     /**
      * @brief Constructor.
@@ -49,13 +145,68 @@ public:
      * @param cols Vector de nombres de columnas.
      */
     EloquentORM(MySQLConexion &connection, const string &tableName, const vector<string> &cols)
-         : db(connection), table(tableName), columns(cols), condition(""), rawQuery("") {
+         : db(connection), table(tableName), columns(cols), condition(""), rawQuery(""), singleFlight(nullptr), analizador(nullptr), lazy(false),
+           exportador(make_shared<MySQLExportador>(connection)) {
          conn = db.getConnection();
          // Inicializar atributos con cadena vacía para cada columna.
          for(auto &col: columns)
              attributes[col] = "";
     }
     
+    /**
+     * @brief Activa la deduplicación single-flight de find() y first().
+     *
+     * Las llamadas concurrentes (desde distintos hilos, cada uno con su propia conexión) que
+     * ejecuten la misma consulta contra el mismo origen de datos comparten una sola ejecución.
+     * Quien se une a una ejecución ya iniciada puede recibir datos leídos justo antes de su
+     * llamada; las lecturas dentro de una transacción nunca se comparten.
+     * El grupo se comparte entre los modelos y debe vivir más que ellos; las copias creadas
+     * con where() y raw() lo heredan.
+     *
+     * @param grupo Grupo single-flight compartido.
+     */
+    void setSingleFlight(SingleFlightRegistro &grupo) {
+         singleFlight = &grupo;
+    }
+    
+    /**
+     * @brief Activa o desactiva la hidratación diferida de find().
+     *
+     * En modo diferido find() conserva el resultado de MySQL en lugar de copiar cada columna:
+     * get() y getView() leen directamente del buffer de la fila, y un campo sólo se copia al
+     * asignarlo con set() o al guardar/eliminar el registro. Con single-flight activo, find()
+     * usa la ruta con copia, ya que el resultado compartido entre hilos es un mapa propio.
+     *
+     * @param activo true para activar la hidratación diferida.
+     */
+    void setLazyHydration(bool activo) {
+         lazy = activo;
+    }
+    
+    /**
+     * @brief Activa el análisis de consultas en modo desarrollo (ver AnalizadorConsultas).
+     *
+     * Las copias creadas con where() y raw() heredan el analizador.
+     *
+     * @param a Analizador que recibirá las consultas; debe vivir más que el modelo.
+     */
+    void setAnalyzer(AnalizadorConsultas &a) {
+         analizador = &a;
+    }
+    
+    /**
+     * @brief Etiqueta la próxima consulta con su punto de llamada para el reporte del analizador.
+     *
+     * La etiqueta se descarta después de esa consulta. Uso típico: modelo.tag(ORM_CALLSITE).find(5).
+     *
+     * @param t Etiqueta (por ejemplo, ORM_CALLSITE).
+     * @return EloquentORM& El propio modelo, para encadenar la llamada.
+     */
+    EloquentORM& tag(const string &t) {
+         etiqueta = t;
+         return *this;
+    }
+    
     /**
      * @brief Asigna un valor a un campo.
      *
@@ -77,6 +228,25 @@ public:
      * @return string Valor del campo.
      */
     string get(const string &field) {
+         return string(getView(field));
+    }
+    
+    /**
+     * @brief Obtiene el valor de un campo sin copiarlo.
+     *
+     * En modo diferido la vista apunta al buffer de la fila leída por find(); en otro caso, al
+     * atributo almacenado. Es válida hasta el próximo find(), set() del campo o la destrucción del modelo.
+     *
+     * @param field Nombre del campo.
+     * @return string_view Valor del campo.
+     */
+    string_view getView(const string &field) {
+         auto it = attributes.find(field);
+         if(it != attributes.end())
+              return it->second;
+         int i = fila.indexOf(field);
+         if(i >= 0)
+              return fila.value((unsigned int)i);
          return attributes[field];
     }
     
@@ -89,21 +259,25 @@ public:
      */
     bool find(int id) {
          string query = "SELECT * FROM " + table + " WHERE id = " + to_string(id) + " LIMIT 1";
-         MYSQL_RES *res = execute(query);
-         if(res) {
-              MYSQL_ROW row = mysql_fetch_row(res);
-              if(row) {
-                   unsigned int num_fields = mysql_num_fields(res);
-                   MYSQL_FIELD *fields = mysql_fetch_fields(res);
-                   for(unsigned int i = 0; i < num_fields; i++) {
-                        attributes[string(fields[i].name)] = (row[i] ? row[i] : "");
-                   }
-                   mysql_free_result(res);
-                   return true;
-              }
-              mysql_free_result(res);
+         if(lazy && !singleFlight) {
+              analizar(query);
+              FilaMySQL nueva(execute(query));
+              if(nueva.empty())
+                   return false;
+              // Los valores de la fila reemplazan a los atributos previos sin copiarse.
+              fila = nueva;
+              for(unsigned int i = 0; i < fila.size(); i++)
+                   attributes.erase(fila.name(i));
+              return true;
          }
-         return false;
+         map<string, string> record = fetchFirst(query);
+         if(record.empty())
+              return false;
+         fila = FilaMySQL();
+         // record es una copia local: sus valores se mueven sin volver a copiarse.
+         for(auto &campo : record)
+              attributes[campo.first] = std::move(campo.second);
+         return true;
     }
     
     /**
@@ -113,7 +287,7 @@ public:
      * @return false En caso de error.
      */
     bool save() {
-         if(attributes.find("id") == attributes.end() || attributes["id"].empty())
+         if(get("id").empty())
               return create();
          else
               return update();
@@ -126,6 +300,7 @@ public:
      * @return false En caso de error.
      */
     bool create() {
+         hidratar();
          stringstream ss;
          ss << "INSERT INTO " << table << " (";
          for(size_t i = 0; i < columns.size(); i++){
@@ -139,6 +314,7 @@ public:
          }
          ss << ")";
          string query = ss.str();
+         analizar(query);
          if(mysql_query(conn, query.c_str())){
               cerr << "Error creando registro: " << mysql_error(conn) << endl;
               return false;
@@ -153,7 +329,9 @@ public:
      * @return false En caso de error.
      */
     bool update() {
-         if(attributes.find("id") == attributes.end() || attributes["id"].empty()){
+         hidratar();
+         string id = get("id");
+         if(id.empty()){
               cerr << "Error al actualizar: 'id' no está definido." << endl;
               return false;
          }
@@ -166,8 +344,9 @@ public:
               ss << col << " = '" << attributes[col] << "'";
               first = false;
          }
-         ss << " WHERE id = " << attributes["id"];
+         ss << " WHERE id = " << id;
          string query = ss.str();
+         analizar(query);
          if(mysql_query(conn, query.c_str())){
               cerr << "Error actualizando registro: " << mysql_error(conn) << endl;
               return false;
@@ -182,11 +361,13 @@ public:
      * @return false En caso de error.
      */
     bool remove() {
-         if(attributes.find("id") == attributes.end() || attributes["id"].empty()){
+         string id = get("id");
+         if(id.empty()){
               cerr << "Error al eliminar: 'id' no está definido." << endl;
               return false;
          }
-         string query = "DELETE FROM " + table + " WHERE id = " + attributes["id"];
+         string query = "DELETE FROM " + table + " WHERE id = " + id;
+         analizar(query);
          if(mysql_query(conn, query.c_str())){
               cerr << "Error eliminando registro: " << mysql_error(conn) << endl;
               return false;
@@ -205,6 +386,7 @@ public:
      */
     EloquentORM where(const string &field, const string &value) {
          EloquentORM newORM = *this; // Copia del objeto actual
+         etiqueta.clear();           // La etiqueta pendiente pasa a la copia
          string newCond = field + " LIKE '%" + value + "%'";
          if(!newORM.condition.empty()){
               newORM.condition += " AND " + newCond;
@@ -225,6 +407,7 @@ public:
     EloquentORM raw(const string &query) {
          EloquentORM newORM = *this;
          newORM.rawQuery = query;
+         etiqueta.clear();
          return newORM;
     }
     
@@ -235,15 +418,8 @@ public:
      */
     vector< map<string, string> > getAll() {
          vector< map<string, string> > rows;
-         string query;
-         if(!rawQuery.empty()){
-              query = rawQuery;
-         } else {
-              query = "SELECT * FROM " + table;
-              if(!condition.empty()){
-                   query += " WHERE " + condition;
-              }
-         }
+         string query = buildQuery();
+         analizar(query);
          MYSQL_RES *res = execute(query);
          if(res){
               MYSQL_ROW row;
@@ -267,30 +443,43 @@ public:
      * @return map<string, string> Mapa con los campos y valores del primer registro encontrado.
      */
     map<string, string> first() {
-         map<string, string> record;
-         string query;
-         if(!rawQuery.empty()){
-              query = rawQuery;
-         } else {
-              query = "SELECT * FROM " + table;
-              if(!condition.empty()){
-                   query += " WHERE " + condition;
-              }
-         }
+         string query = buildQuery();
          query += " LIMIT 1";
-         MYSQL_RES *res = execute(query);
-         if(res) {
-              MYSQL_ROW row = mysql_fetch_row(res);
-              if(row){
-                   unsigned int num_fields = mysql_num_fields(res);
-                   MYSQL_FIELD *fields = mysql_fetch_fields(res);
-                   for(unsigned int i = 0; i < num_fields; i++){
-                        record[string(fields[i].name)] = (row[i] ? row[i] : "");
-                   }
-              }
-              mysql_free_result(res);
-         }
-         return record;
+         return fetchFirst(query);
+    }
+
+    /**
+     * @brief Obtiene el primer registro que cumpla la condición (o de la consulta raw) sin copiar sus campos.
+     *
+     * Variante de first() que conserva el resultado de MySQL y permite leer cada campo como string_view.
+     *
+     * @return FilaMySQL Fila encontrada (empty() si no hubo resultados).
+     */
+    FilaMySQL firstRow() {
+         string query = buildQuery();
+         query += " LIMIT 1";
+         analizar(query);
+         return FilaMySQL(execute(query));
+    }
+    
+    /**
+     * @brief Exporta en streaming los registros que cumplan la condición (o de la consulta raw) a un descriptor de archivo.
+     *
+     * A diferencia de getAll(), no materializa el resultado: las filas se leen una a una y se
+     * escriben formateadas a través de un buffer reutilizable (ver MySQLExportador). El buffer
+     * pertenece al modelo y lo comparten las copias creadas con where() y raw(), por lo que
+     * las exportaciones sucesivas no vuelven a reservarlo.
+     *
+     * @param fd Descriptor de archivo abierto para escritura (no se cierra).
+     * @param formato Formato de salida: CSV, NDJSON o COLUMNAR.
+     * @param tamBuffer Tamaño en bytes del buffer de salida (por defecto: 1 MiB).
+     * @return long long Número de filas exportadas o -1 en caso de error.
+     */
+    long long exportar(int fd, FormatoExportacion formato, size_t tamBuffer = 1 << 20) {
+         string query = buildQuery();
+         analizar(query);
+         exportador->setTamBuffer(tamBuffer);
+         return exportador->exportar(query, fd, formato);
     }
 };
 
@@ -0,0 +1,140 @@
+#ifndef FILAMYSQL_H
+#define FILAMYSQL_H
+
+#include <mysql.h>
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief Fila de un resultado MySQL cuyos valores se leen sin copiarlos.
+ *
+ * Conserva vivo el MYSQL_RES (obtenido con mysql_store_result()) del que proviene la fila y
+ * expone cada campo como string_view sobre el buffer del cliente MySQL, usando los largos de
+ * mysql_fetch_lengths() (por lo que los valores binarios con '\0' se leen completos). Las
+ * copias de una FilaMySQL comparten el mismo resultado, que se libera con la última copia.
+ *
+ * Al leer la fila se construye una sola vez un índice nombre→posición ordenado (con vistas a
+ * los nombres del propio resultado, sin copiarlos), de modo que cada búsqueda por nombre es
+ * logarítmica aun en tablas con muchas columnas.
+ */
+class FilaMySQL {
+private:
+    shared_ptr<MYSQL_RES> res;
+    MYSQL_ROW row;
+    unsigned long *lengths;
+    MYSQL_FIELD *fields;
+    unsigned int num_fields;
+    shared_ptr< vector< pair<string_view, unsigned int> > > indice; // Nombres ordenados y su posición
+
+public:
+    /**
+     * @brief Constructor de una fila vacía.
+     */
+    FilaMySQL() : row(nullptr), lengths(nullptr), fields(nullptr), num_fields(0) {}
+
+    /**
+     * @brief Toma posesión del resultado y lee su primera fila.
+     *
+     * @param resultado Resultado de mysql_store_result(); puede ser nullptr. Se libera con la última copia.
+     */
+    explicit FilaMySQL(MYSQL_RES *resultado)
+        : res(resultado, mysql_free_result), row(nullptr), lengths(nullptr), fields(nullptr), num_fields(0) {
+        if(!resultado) return;
+        row = mysql_fetch_row(resultado);
+        if(row) {
+            lengths = mysql_fetch_lengths(resultado);
+            fields = mysql_fetch_fields(resultado);
+            num_fields = mysql_num_fields(resultado);
+            indice = make_shared< vector< pair<string_view, unsigned int> > >();
+            indice->reserve(num_fields);
+            for(unsigned int i = 0; i < num_fields; i++)
+                indice->emplace_back(string_view(fields[i].name), i);
+            sort(indice->begin(), indice->end());
+        } else {
+            res.reset();
+        }
+    }
+
+    /**
+     * @brief Indica si la fila no contiene datos (no hubo resultados).
+     */
+    bool empty() const {
+        return row == nullptr;
+    }
+
+    /**
+     * @brief Retorna la posición de un campo o -1 si no existe.
+     *
+     * @param field Nombre del campo.
+     */
+    int indexOf(string_view field) const {
+        if(!indice)
+            return -1;
+        auto it = lower_bound(indice->begin(), indice->end(), field,
+                              [](const pair<string_view, unsigned int> &a, string_view b) { return a.first < b; });
+        if(it == indice->end() || it->first != field)
+            return -1;
+        return (int)it->second;
+    }
+
+    /**
+     * @brief Indica si la fila contiene el campo.
+     */
+    bool has(string_view field) const {
+        return indexOf(field) >= 0;
+    }
+
+    /**
+     * @brief Obtiene el valor de un campo sin copiarlo.
+     *
+     * La vista es válida mientras exista alguna copia de esta fila.
+     *
+     * @param field Nombre del campo.
+     * @return string_view Valor del campo o vista vacía si no existe o es NULL.
+     */
+    string_view get(string_view field) const {
+        int i = indexOf(field);
+        return i < 0 ? string_view() : value((unsigned int)i);
+    }
+
+    /**
+     * @brief Número de campos de la fila.
+     */
+    unsigned int size() const {
+        return num_fields;
+    }
+
+    /**
+     * @brief Nombre del campo en la posición indicada.
+     */
+    const char* name(unsigned int i) const {
+        return fields[i].name;
+    }
+
+    /**
+     * @brief Valor del campo en la posición indicada (vista vacía si es NULL).
+     */
+    string_view value(unsigned int i) const {
+        return row[i] ? string_view(row[i], lengths[i]) : string_view();
+    }
+
+    /**
+     * @brief Copia todos los campos a un mapa campo-valor (igual que first()).
+     */
+    map<string, string> toMap() const {
+        map<string, string> record;
+        for(unsigned int i = 0; i < num_fields; i++) {
+            record[string(fields[i].name)] = string(value(i));
+        }
+        return record;
+    }
+};
+
+#endif // FILAMYSQL_H
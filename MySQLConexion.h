@@ -101,6 +101,15 @@ public:
         return conn;
     }
     
+    /**
+     * @brief Retorna un identificador del origen de datos con el formato usuario@host:puerto/base.
+     *
+     * Dos conexiones con el mismo identificador ven los mismos datos con los mismos permisos.
+     */
+    string getDSN() const {
+        return user + "@" + host + ":" + to_string(port) + "/" + database;
+    }
+    
     ~MySQLConexion() {
         close();
     }
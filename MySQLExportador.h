@@ -0,0 +1,451 @@
+#ifndef MYSQLEXPORTADOR_H
+#define MYSQLEXPORTADOR_H
+
+#include "MySQLConexion.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <iostream>
+#include <mysql.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Formatos de salida soportados por MySQLExportador.
+ */
+enum class FormatoExportacion {
+    CSV,      // Valores separados por coma con encabezado (RFC 4180, NULL como campo vacío).
+    NDJSON,   // Un objeto JSON por línea (columnas binarias en base64).
+    COLUMNAR  // Binario columnar por bloques (ver exportarColumnar()).
+};
+
+/**
+ * @brief Exporta el resultado de una consulta directamente a un descriptor de archivo.
+ *
+ * Las filas se leen con mysql_use_result(), es decir, una a una desde la red sin
+ * materializar el resultado completo, y se formatean dentro de un buffer reutilizable
+ * que se vuelca al descriptor cuando se llena. La memoria usada es acotada por el
+ * tamaño del buffer (y, en el formato columnar, por el tamaño de bloque), de modo que
+ * se pueden exportar tablas más grandes que la RAM disponible.
+ *
+ * Mientras dura la exportación la conexión queda ocupada leyendo el resultado: no se
+ * deben lanzar otras consultas sobre ella hasta que exportar() retorne.
+ */
+class MySQLExportador {
+private:
+    MYSQL *conn;
+    vector<char> buffer;                 // Buffer de salida reutilizable (se reserva en la primera exportación)
+    size_t tamBuffer;                    // Tamaño deseado del buffer
+    size_t usado;                        // Bytes ocupados en el buffer
+    size_t filasPorBloque;               // Máximo de filas por bloque columnar
+    int fd;                              // Descriptor de destino de la exportación en curso
+    bool errorEscritura;
+
+    // Acumuladores por columna del formato columnar (se reutilizan entre bloques).
+    vector< vector<char> > datosColumna;
+    vector< vector<uint32_t> > largosColumna;
+    vector< vector<uint8_t> > nulosColumna;
+
+    /**
+     * @brief Escribe un bloque de bytes en el descriptor, reintentando escrituras parciales.
+     */
+    bool escribir(const char *datos, size_t n) {
+        while(n > 0) {
+#ifdef _WIN32
+            int escrito = _write(fd, datos, (unsigned int)(n > 0x40000000 ? 0x40000000 : n));
+#else
+            ssize_t escrito = ::write(fd, datos, n);
+#endif
+            if(escrito < 0) {
+                if(errno == EINTR) continue;
+                cerr << "Error escribiendo la exportación: " << strerror(errno) << endl;
+                return false;
+            }
+            datos += escrito;
+            n -= (size_t)escrito;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Vuelca el contenido del buffer al descriptor.
+     */
+    void vaciar() {
+        if(usado > 0 && !errorEscritura) {
+            errorEscritura = !escribir(buffer.data(), usado);
+        }
+        usado = 0;
+    }
+
+    /**
+     * @brief Agrega bytes al buffer; los bloques mayores que el buffer se escriben directamente.
+     */
+    void agregar(const char *datos, size_t n) {
+        if(usado + n > buffer.size()) {
+            vaciar();
+            if(n > buffer.size()) {
+                if(!errorEscritura) errorEscritura = !escribir(datos, n);
+                return;
+            }
+        }
+        memcpy(buffer.data() + usado, datos, n);
+        usado += n;
+    }
+
+    void agregar(char c) {
+        if(usado == buffer.size()) vaciar();
+        buffer[usado++] = c;
+    }
+
+    void agregar(const string &s) {
+        agregar(s.data(), s.size());
+    }
+
+    void agregarU32(uint32_t v) {
+        char b[4] = { (char)(v & 0xFF), (char)((v >> 8) & 0xFF), (char)((v >> 16) & 0xFF), (char)((v >> 24) & 0xFF) };
+        agregar(b, 4);
+    }
+
+    void agregarU64(uint64_t v) {
+        agregarU32((uint32_t)(v & 0xFFFFFFFFu));
+        agregarU32((uint32_t)(v >> 32));
+    }
+
+    /**
+     * @brief Agrega un valor como campo CSV, entre comillas sólo si contiene caracteres especiales.
+     */
+    void agregarCSV(const char *valor, unsigned long largo) {
+        bool requiereComillas = false;
+        for(unsigned long i = 0; i < largo; i++) {
+            char c = valor[i];
+            if(c == ',' || c == '"' || c == '\n' || c == '\r') {
+                requiereComillas = true;
+                break;
+            }
+        }
+        if(!requiereComillas) {
+            agregar(valor, largo);
+            return;
+        }
+        agregar('"');
+        unsigned long inicio = 0;
+        for(unsigned long i = 0; i < largo; i++) {
+            if(valor[i] == '"') {
+                agregar(valor + inicio, i - inicio + 1);
+                agregar('"');
+                inicio = i + 1;
+            }
+        }
+        agregar(valor + inicio, largo - inicio);
+        agregar('"');
+    }
+
+    /**
+     * @brief Agrega un valor como cadena JSON escapada (incluye las comillas).
+     */
+    void agregarJSON(const char *valor, unsigned long largo) {
+        static const char hex[] = "0123456789abcdef";
+        agregar('"');
+        unsigned long inicio = 0;
+        for(unsigned long i = 0; i < largo; i++) {
+            unsigned char c = (unsigned char)valor[i];
+            if(c >= 0x20 && c != '"' && c != '\\') continue;
+            agregar(valor + inicio, i - inicio);
+            inicio = i + 1;
+            switch(c) {
+                case '"':  agregar("\\\"", 2); break;
+                case '\\': agregar("\\\\", 2); break;
+                case '\n': agregar("\\n", 2); break;
+                case '\r': agregar("\\r", 2); break;
+                case '\t': agregar("\\t", 2); break;
+                default: {
+                    char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                    agregar(esc, 6);
+                }
+            }
+        }
+        agregar(valor + inicio, largo - inicio);
+        agregar('"');
+    }
+
+    /**
+     * @brief Escapa un texto como cadena JSON (con comillas) en un string propio, sin usar el buffer.
+     *
+     * Se usa para preparar las claves; los valores se escapan directamente en el buffer con agregarJSON().
+     */
+    static string escaparJSON(const char *valor, size_t largo) {
+        static const char hex[] = "0123456789abcdef";
+        string salida = "\"";
+        for(size_t i = 0; i < largo; i++) {
+            unsigned char c = (unsigned char)valor[i];
+            switch(c) {
+                case '"':  salida += "\\\""; break;
+                case '\\': salida += "\\\\"; break;
+                case '\n': salida += "\\n"; break;
+                case '\r': salida += "\\r"; break;
+                case '\t': salida += "\\t"; break;
+                default:
+                    if(c < 0x20) {
+                        char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                        salida.append(esc, 6);
+                    } else {
+                        salida += (char)c;
+                    }
+            }
+        }
+        salida += '"';
+        return salida;
+    }
+
+    /**
+     * @brief Agrega un valor binario como cadena JSON codificada en base64 (incluye las comillas).
+     */
+    void agregarBase64(const char *valor, unsigned long largo) {
+        static const char tabla[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const unsigned char *d = (const unsigned char*)valor;
+        agregar('"');
+        unsigned long i = 0;
+        for(; i + 3 <= largo; i += 3) {
+            char b[4] = { tabla[d[i] >> 2], tabla[((d[i] & 0x03) << 4) | (d[i + 1] >> 4)],
+                          tabla[((d[i + 1] & 0x0F) << 2) | (d[i + 2] >> 6)], tabla[d[i + 2] & 0x3F] };
+            agregar(b, 4);
+        }
+        if(largo - i == 1) {
+            char b[4] = { tabla[d[i] >> 2], tabla[(d[i] & 0x03) << 4], '=', '=' };
+            agregar(b, 4);
+        } else if(largo - i == 2) {
+            char b[4] = { tabla[d[i] >> 2], tabla[((d[i] & 0x03) << 4) | (d[i + 1] >> 4)], tabla[(d[i + 1] & 0x0F) << 2], '=' };
+            agregar(b, 4);
+        }
+        agregar('"');
+    }
+
+    /**
+     * @brief Indica si una columna contiene bytes arbitrarios (BINARY, VARBINARY, BLOB, BIT, GEOMETRY).
+     *
+     * Se reconoce por el juego de caracteres binario (63); los tipos numéricos y temporales
+     * también lo usan, pero su valor textual siempre es ASCII.
+     */
+    static bool esBinario(const MYSQL_FIELD &field) {
+        if(field.charsetnr != 63) return false;
+        switch(field.type) {
+            case MYSQL_TYPE_VARCHAR: case MYSQL_TYPE_VAR_STRING: case MYSQL_TYPE_STRING:
+            case MYSQL_TYPE_TINY_BLOB: case MYSQL_TYPE_MEDIUM_BLOB: case MYSQL_TYPE_LONG_BLOB:
+            case MYSQL_TYPE_BLOB: case MYSQL_TYPE_BIT: case MYSQL_TYPE_GEOMETRY:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    long long exportarCSV(MYSQL_RES *res) {
+        unsigned int num_fields = mysql_num_fields(res);
+        MYSQL_FIELD *fields = mysql_fetch_fields(res);
+        for(unsigned int i = 0; i < num_fields; i++) {
+            if(i > 0) agregar(',');
+            agregarCSV(fields[i].name, strlen(fields[i].name));
+        }
+        agregar('\n');
+
+        long long filas = 0;
+        MYSQL_ROW row;
+        while(!errorEscritura && (row = mysql_fetch_row(res))) {
+            unsigned long *lengths = mysql_fetch_lengths(res);
+            for(unsigned int i = 0; i < num_fields; i++) {
+                if(i > 0) agregar(',');
+                if(row[i]) agregarCSV(row[i], lengths[i]);
+            }
+            agregar('\n');
+            filas++;
+        }
+        return filas;
+    }
+
+    /**
+     * @brief Formato NDJSON: un objeto por fila, con NULL como null y los números sin comillas.
+     *
+     * Las columnas binarias se escriben en base64. Las columnas de texto se copian tal cual
+     * (escapando sólo comillas, barras y caracteres de control), por lo que el juego de
+     * caracteres de la conexión debe ser UTF-8 (utf8mb4) para que la salida sea JSON válido.
+     */
+    long long exportarNDJSON(MYSQL_RES *res) {
+        unsigned int num_fields = mysql_num_fields(res);
+        MYSQL_FIELD *fields = mysql_fetch_fields(res);
+
+        // Las claves escapadas ("{\"id\":", ",\"nombre\":", ...) se preparan una sola vez.
+        vector<string> claves(num_fields);
+        vector<bool> numerico(num_fields);
+        vector<bool> binario(num_fields);
+        for(unsigned int i = 0; i < num_fields; i++) {
+            claves[i] = string(i == 0 ? "{" : ",") + escaparJSON(fields[i].name, strlen(fields[i].name)) + ":";
+            numerico[i] = IS_NUM(fields[i].type);
+            binario[i] = esBinario(fields[i]);
+        }
+
+        long long filas = 0;
+        MYSQL_ROW row;
+        while(!errorEscritura && (row = mysql_fetch_row(res))) {
+            unsigned long *lengths = mysql_fetch_lengths(res);
+            for(unsigned int i = 0; i < num_fields; i++) {
+                agregar(claves[i]);
+                if(!row[i]) agregar("null", 4);
+                else if(numerico[i]) agregar(row[i], lengths[i]);
+                else if(binario[i]) agregarBase64(row[i], lengths[i]);
+                else agregarJSON(row[i], lengths[i]);
+            }
+            agregar(num_fields == 0 ? "{}\n" : "}\n", num_fields == 0 ? 3 : 2);
+            filas++;
+        }
+        return filas;
+    }
+
+    /**
+     * @brief Escribe el bloque columnar acumulado y deja los acumuladores vacíos (conservando su capacidad).
+     */
+    void vaciarBloque(uint32_t filasBloque) {
+        if(filasBloque == 0) return;
+        agregarU32(filasBloque);
+        for(size_t c = 0; c < datosColumna.size(); c++) {
+            agregarU64(datosColumna[c].size());
+            for(uint32_t largo : largosColumna[c]) agregarU32(largo);
+            agregar((const char*)nulosColumna[c].data(), nulosColumna[c].size());
+            agregar(datosColumna[c].data(), datosColumna[c].size());
+            datosColumna[c].clear();
+            largosColumna[c].clear();
+            nulosColumna[c].clear();
+        }
+    }
+
+    /**
+     * @brief Formato columnar binario (todos los enteros en little-endian):
+     *
+     * - Encabezado: "ELORMCOL", u32 versión (1), u32 número de columnas y, por columna,
+     *   u8 tipo MySQL (enum_field_types), u32 largo del nombre y el nombre.
+     * - Bloques: u32 filas del bloque y, por columna, u64 bytes de datos, u32 largo de
+     *   cada fila, mapa de nulos (un bit por fila, bit 1 = NULL) y los datos concatenados.
+     * - Fin: u32 0.
+     *
+     * Un bloque se cierra al llegar a filasPorBloque filas o cuando sus datos superan el
+     * tamaño del buffer, lo que acota la memoria usada por los acumuladores.
+     */
+    long long exportarColumnar(MYSQL_RES *res) {
+        unsigned int num_fields = mysql_num_fields(res);
+        MYSQL_FIELD *fields = mysql_fetch_fields(res);
+        agregar("ELORMCOL", 8);
+        agregarU32(1);
+        agregarU32(num_fields);
+        for(unsigned int i = 0; i < num_fields; i++) {
+            size_t largo = strlen(fields[i].name);
+            agregar((char)(uint8_t)fields[i].type);
+            agregarU32((uint32_t)largo);
+            agregar(fields[i].name, largo);
+        }
+
+        datosColumna.resize(num_fields);
+        largosColumna.resize(num_fields);
+        nulosColumna.resize(num_fields);
+
+        long long filas = 0;
+        uint32_t filasBloque = 0;
+        size_t bytesBloque = 0;
+        MYSQL_ROW row;
+        while(!errorEscritura && (row = mysql_fetch_row(res))) {
+            unsigned long *lengths = mysql_fetch_lengths(res);
+            for(unsigned int i = 0; i < num_fields; i++) {
+                if(filasBloque % 8 == 0) nulosColumna[i].push_back(0);
+                if(row[i]) {
+                    datosColumna[i].insert(datosColumna[i].end(), row[i], row[i] + lengths[i]);
+                    largosColumna[i].push_back((uint32_t)lengths[i]);
+                    bytesBloque += lengths[i];
+                } else {
+                    nulosColumna[i].back() |= (uint8_t)(1u << (filasBloque % 8));
+                    largosColumna[i].push_back(0);
+                }
+            }
+            filasBloque++;
+            filas++;
+            if(filasBloque >= filasPorBloque || bytesBloque >= buffer.size()) {
+                vaciarBloque(filasBloque);
+                filasBloque = 0;
+                bytesBloque = 0;
+            }
+        }
+        vaciarBloque(filasBloque);
+        agregarU32(0);
+        return filas;
+    }
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param db Referencia a la conexión MySQL.
+     * @param tamBuffer Tamaño en bytes del buffer de salida (por defecto: 1 MiB).
+     * @param filasPorBloque Máximo de filas por bloque en el formato columnar (por defecto: 65536).
+     */
+    MySQLExportador(MySQLConexion &db, size_t tamBuffer = 1 << 20, size_t filasPorBloque = 65536)
+        : conn(db.getConnection()), tamBuffer(tamBuffer > 4096 ? tamBuffer : 4096), usado(0),
+          filasPorBloque(filasPorBloque > 0 ? filasPorBloque : 1), fd(-1), errorEscritura(false) {}
+
+    /**
+     * @brief Cambia el tamaño del buffer de salida a partir de la próxima exportación.
+     *
+     * @param tam Tamaño en bytes (mínimo: 4096).
+     */
+    void setTamBuffer(size_t tam) {
+        tamBuffer = tam > 4096 ? tam : 4096;
+    }
+
+    /**
+     * @brief Ejecuta una consulta y escribe su resultado en el descriptor indicado.
+     *
+     * El descriptor no se cierra; el llamador conserva su propiedad. El buffer se reserva en
+     * la primera llamada y se reutiliza en las siguientes mientras no cambie su tamaño.
+     *
+     * @param query Consulta SELECT a exportar.
+     * @param destino Descriptor de archivo abierto para escritura.
+     * @param formato Formato de salida.
+     * @return long long Número de filas exportadas o -1 en caso de error.
+     */
+    long long exportar(const string &query, int destino, FormatoExportacion formato) {
+        if(mysql_query(conn, query.c_str())) {
+            cerr << "Error en la consulta: " << mysql_error(conn) << endl;
+            return -1;
+        }
+        MYSQL_RES *res = mysql_use_result(conn);
+        if(!res) {
+            cerr << "Error en la consulta: " << mysql_error(conn) << endl;
+            return -1;
+        }
+        if(buffer.size() != tamBuffer)
+            vector<char>(tamBuffer).swap(buffer);
+        fd = destino;
+        usado = 0;
+        errorEscritura = false;
+
+        long long filas;
+        switch(formato) {
+            case FormatoExportacion::CSV:    filas = exportarCSV(res); break;
+            case FormatoExportacion::NDJSON: filas = exportarNDJSON(res); break;
+            default:                         filas = exportarColumnar(res); break;
+        }
+        vaciar();
+
+        // Con mysql_use_result un error de red aparece como fin prematuro de las filas.
+        bool errorLectura = !errorEscritura && mysql_errno(conn) != 0;
+        if(errorLectura) {
+            cerr << "Error leyendo el resultado: " << mysql_error(conn) << endl;
+        }
+        mysql_free_result(res);
+        return (errorEscritura || errorLectura) ? -1 : filas;
+    }
+};
+
+#endif // MYSQLEXPORTADOR_H
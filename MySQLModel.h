@@ -10,6 +10,7 @@
 using namespace std;
 
 #include "MySQLConexion.h"
+#include "AnalizadorConsultas.h"
 
 /**
  * @brief Clase que representa un modelo genérico para interactuar con cualquier tabla de la base de datos.
@@ -22,6 +23,19 @@ private:
     string table;
     vector<string> columns;              // Lista de columnas definidas (orden importante)
     map<string, string> attributes;      // Atributos del modelo (par clave-valor)
+    AnalizadorConsultas *analizador;     // Analizador de consultas en modo desarrollo (opcional)
+    string etiqueta;                     // Punto de llamada de la próxima consulta (ver tag())
+
+    /**
+     * @brief Notifica la consulta al analizador (si hay uno) y descarta la etiqueta ya usada.
+     * 
+     * @param query Consulta SQL que está por ejecutarse.
+     */
+    void analizar(const string &query) {
+        if(analizador)
+            analizador->observar(conn, query, etiqueta);
+        etiqueta.clear();
+    }
 
     /**
      * @brief Función auxiliar para ejecutar una consulta y obtener el resultado.
@@ -41,7 +55,7 @@ public:
     /**
      * @brief Constructor por defecto.
      */
-    MySQLModel() : conn(nullptr) {}
+    MySQLModel() : conn(nullptr), analizador(nullptr) {}
     
     /**
      * @brief Configura la conexión y el nombre de la tabla.
@@ -54,6 +68,28 @@ public:
         table = tableName;
     }
     
+    /**
+     * @brief Activa el análisis de consultas en modo desarrollo (ver AnalizadorConsultas).
+     * 
+     * @param a Analizador que recibirá las consultas; debe vivir más que el modelo.
+     */
+    void setAnalyzer(AnalizadorConsultas &a) {
+        analizador = &a;
+    }
+    
+    /**
+     * @brief Etiqueta la próxima consulta con su punto de llamada para el reporte del analizador.
+     * 
+     * La etiqueta se descarta después de esa consulta. Uso típico: modelo.tag(ORM_CALLSITE).find(5).
+     * 
+     * @param t Etiqueta (por ejemplo, ORM_CALLSITE).
+     * @return MySQLModel& El propio modelo, para encadenar la llamada.
+     */
+    MySQLModel& tag(const string &t) {
+        etiqueta = t;
+        return *this;
+    }
+    
     /**
      * @brief Define los nombres de las columnas y crea los atributos inicializados en cadena vacía.
      * 
@@ -106,6 +142,7 @@ public:
      */
     bool find(int id) {
         string query = "SELECT * FROM " + table + " WHERE id = " + to_string(id) + " LIMIT 1";
+        analizar(query);
         MYSQL_RES *res = execute(query);
         if(res) {
             MYSQL_ROW row = mysql_fetch_row(res);
@@ -143,6 +180,7 @@ public:
         }
         ss << ")";
         string query = ss.str();
+        analizar(query);
         if(mysql_query(conn, query.c_str())) {
             cerr << "Error al crear registro: " << mysql_error(conn) << endl;
             return false;
@@ -174,6 +212,7 @@ public:
         }
         ss << " WHERE id = " << attributes["id"];
         string query = ss.str();
+        analizar(query);
         if(mysql_query(conn, query.c_str())) {
             cerr << "Error al actualizar: " << mysql_error(conn) << endl;
             return false;
@@ -195,6 +234,7 @@ public:
             return false;
         }
         string query = "DELETE FROM " + table + " WHERE id = " + attributes["id"];
+        analizar(query);
         if(mysql_query(conn, query.c_str())) {
             cerr << "Error al eliminar: " << mysql_error(conn) << endl;
             return false;
@@ -210,6 +250,7 @@ public:
     vector< map<string, string> > getAll() {
         vector< map<string, string> > rows;
         string query = "SELECT * FROM " + table;
+        analizar(query);
         MYSQL_RES *res = execute(query);
         if(res) {
             MYSQL_ROW row;
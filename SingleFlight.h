@@ -0,0 +1,106 @@
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <map>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @brief Deduplica ejecuciones concurrentes de una misma operación identificada por una clave.
+ *
+ * Si varios hilos llaman a hacer() con la misma clave mientras una ejecución está en curso,
+ * sólo el primero (líder) ejecuta la función; los demás esperan y reciben el mismo resultado
+ * inmutable. Al terminar la ejecución la clave se libera: no se guarda ningún resultado para
+ * llamadas posteriores. Quien se une a una ejecución en curso puede recibir datos leídos un
+ * poco antes de su propia llamada (por ejemplo, sin una escritura que confirmó justo antes).
+ *
+ * Una misma instancia se comparte entre los hilos (cada uno con su propia conexión MySQL).
+ */
+template <typename T>
+class SingleFlight {
+public:
+    /**
+     * @brief Contadores acumulados desde la creación del grupo.
+     */
+    struct Estadisticas {
+        unsigned long long ejecutadas;   // Llamadas que ejecutaron la función (líderes)
+        unsigned long long compartidas;  // Llamadas que reutilizaron una ejecución en curso
+    };
+
+private:
+    struct Llamada {
+        condition_variable cv;
+        bool terminada = false;
+        shared_ptr<const T> resultado;
+        exception_ptr error;
+    };
+
+    mutable mutex mtx;
+    map<string, shared_ptr<Llamada> > enCurso;
+    Estadisticas stats = {0, 0};
+
+public:
+    SingleFlight() {}
+    SingleFlight(const SingleFlight &) = delete;
+    SingleFlight &operator=(const SingleFlight &) = delete;
+
+    /**
+     * @brief Ejecuta fn() o se une a la ejecución en curso con la misma clave.
+     *
+     * Si fn() lanza una excepción, ésta se propaga al líder y a todos los que esperaban.
+     *
+     * @param clave Identificador de la operación (por ejemplo, conexión y consulta SQL).
+     * @param fn Función que produce el resultado.
+     * @return shared_ptr<const T> Resultado compartido e inmutable.
+     */
+    shared_ptr<const T> hacer(const string &clave, const function<T()> &fn) {
+        unique_lock<mutex> lock(mtx);
+        auto it = enCurso.find(clave);
+        if(it != enCurso.end()) {
+            shared_ptr<Llamada> llamada = it->second;
+            stats.compartidas++;
+            llamada->cv.wait(lock, [&]{ return llamada->terminada; });
+            if(llamada->error) rethrow_exception(llamada->error);
+            return llamada->resultado;
+        }
+        shared_ptr<Llamada> llamada = make_shared<Llamada>();
+        enCurso[clave] = llamada;
+        stats.ejecutadas++;
+        lock.unlock();
+
+        shared_ptr<const T> resultado;
+        exception_ptr error;
+        try {
+            resultado = make_shared<const T>(fn());
+        } catch(...) {
+            error = current_exception();
+        }
+
+        lock.lock();
+        llamada->resultado = resultado;
+        llamada->error = error;
+        llamada->terminada = true;
+        enCurso.erase(clave);
+        lock.unlock();
+        llamada->cv.notify_all();
+
+        if(error) rethrow_exception(error);
+        return resultado;
+    }
+
+    /**
+     * @brief Retorna una copia de los contadores de ejecuciones y solicitudes colapsadas.
+     */
+    Estadisticas estadisticas() const {
+        lock_guard<mutex> lock(mtx);
+        return stats;
+    }
+};
+
+#endif // SINGLEFLIGHT_H
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include "MySQLConexion.h"
 #include "EloquentORM.h"
 
@@ -59,6 +60,13 @@ for (const auto &registro : todos) {
              << ", Nombre: " << reg["nombre"]
              << ", Asiento: " << reg["asiento"] << endl;
     }
+    // 6.1 Exportar la tabla en streaming a CSV sin cargarla en memoria.
+    FILE *archivo = fopen("boletos.csv", "wb");
+    if(archivo){
+        long long exportados = boleto.exportar(fileno(archivo), FormatoExportacion::CSV);
+        cout << "\nRegistros exportados a 'boletos.csv': " << exportados << endl;
+        fclose(archivo);
+    }
     // 7. Usar el método where para filtrar registros.
     EloquentORM filtro = boleto.where("nombre", "Juan Perez");
     vector< map<string, string> > resultados = filtro.getAll();